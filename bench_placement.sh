@@ -0,0 +1,45 @@
+#!/bin/bash
+
+# Benchmark Part 2b under each CPU placement policy
+# Usage: ./bench_placement.sh [number_of_TAs] [delay_scale] [runs]
+
+NUM_TAS=${1:-4}
+DELAY_SCALE=${2:-0.01}
+RUNS=${3:-3}
+BINARY=./ta_marking_semaphore_101116888_101276841
+
+if [ ! -x "$BINARY" ]; then
+    echo "Program not compiled. Compiling now..."
+    make part2b > /dev/null
+fi
+
+echo "======================================"
+echo "Placement benchmark: $NUM_TAS TAs, delay scale $DELAY_SCALE, $RUNS runs"
+echo "CPUs: $(nproc)   NUMA nodes: $(ls -d /sys/devices/system/node/node* 2>/dev/null | wc -l)"
+echo "======================================"
+printf "%-10s %12s %12s %12s\n" "policy" "best (s)" "mean (s)" "exams/s"
+
+for policy in none compact scatter node; do
+    total=0
+    best=""
+    exams=0
+    for run in $(seq 1 "$RUNS"); do
+        bash ./generate_test_files.sh > /dev/null 2>&1
+        start=$(date +%s.%N)
+        output=$("$BINARY" "$NUM_TAS" --placement=$policy --delay-scale=$DELAY_SCALE 2>&1)
+        end=$(date +%s.%N)
+        elapsed=$(awk -v s="$start" -v e="$end" 'BEGIN { printf "%.3f", e - s }')
+        total=$(awk -v t="$total" -v e="$elapsed" 'BEGIN { printf "%.3f", t + e }')
+        if [ -z "$best" ] || awk -v e="$elapsed" -v b="$best" 'BEGIN { exit !(e < b) }'; then
+            best=$elapsed
+        fi
+        # Every exam after the first is announced by a LOADED message
+        exams=$(( $(echo "$output" | grep -c "LOADED exam for student") + 1 ))
+    done
+    mean=$(awk -v t="$total" -v r="$RUNS" 'BEGIN { printf "%.3f", t / r }')
+    rate=$(awk -v x="$exams" -v m="$mean" 'BEGIN { printf "%.2f", x / m }')
+    printf "%-10s %12.3f %12.3f %12s\n" "$policy" "$best" "$mean" "$rate"
+done
+
+# Leave the test files in their initial state
+bash ./generate_test_files.sh > /dev/null 2>&1
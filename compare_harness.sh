@@ -0,0 +1,167 @@
+#!/bin/bash
+
+# Synchronisation overhead harness for Part 2a vs Part 2b
+# Usage: ./compare_harness.sh [number_of_TAs] [delay_scale] [seed] [runs]
+#
+# Runs both programs with the same TA count, delay scale and random seeds,
+# then checks each run's log and final rubric for:
+#   - duplicate markings: the same student/question marked more than once
+#   - skipped exams: students whose questions were never marked
+#   - incomplete exams: students with fewer than 5 distinct questions marked
+#   - lost rubric updates: corrections logged minus corrections that reached
+#     rubric.txt
+# and reports throughput next to these correctness counts.
+
+NUM_TAS=${1:-3}
+DELAY_SCALE=${2:-0.001}
+SEED=${3:-42}
+RUNS=${4:-5}
+TIMEOUT=60
+BINARY_2A=./ta_marking_101116888_101276841
+BINARY_2B=./ta_marking_semaphore_101116888_101276841
+
+if [ ! -x "$BINARY_2A" ] || [ ! -x "$BINARY_2B" ]; then
+    echo "Programs not compiled. Compiling now..."
+    make part2a part2b > /dev/null
+fi
+
+# Students the run is expected to mark (exam_0001 up to the first gap or 9999)
+expected_students() {
+    local index=1
+    while true; do
+        local file=$(printf "exam_%04d.txt" $index)
+        [ -f "$file" ] || break
+        local student=$(head -n 1 "$file")
+        [ "$student" == "9999" ] && break
+        echo $((10#$student))
+        index=$((index + 1))
+    done
+}
+
+# Rubric letters, one per line, as character codes
+rubric_codes() {
+    while IFS= read -r line; do
+        local letter="${line#*, }"
+        printf "%d\n" "'${letter:0:1}"
+    done < rubric.txt
+}
+
+# Function to run one binary once and print a result row
+run_once() {
+    local label=$1
+    local binary=$2
+    local seed=$3
+    local log=$4
+
+    bash ./generate_test_files.sh > /dev/null 2>&1
+    local expected=$(expected_students | tr '\n' ' ')
+    local initial=$(rubric_codes | tr '\n' ' ')
+
+    local start=$(date +%s.%N)
+    timeout $TIMEOUT "$binary" "$NUM_TAS" --delay-scale=$DELAY_SCALE --seed=$seed > "$log" 2>&1
+    local status=$?
+    local end=$(date +%s.%N)
+    local final=$(rubric_codes | tr '\n' ' ')
+
+    awk -v label="$label" -v seed="$seed" -v start="$start" -v end="$end" -v status="$status" \
+        -v expected="$expected" -v initial="$initial" -v final="$final" '
+        # Part 2a: "] Marking student S, question Q"; Part 2b: "] MARKING student S, question Q"
+        /\] (Marking|MARKING) student [0-9]+, question [0-9]+/ {
+            match($0, /student [0-9]+, question [0-9]+/)
+            split(substr($0, RSTART, RLENGTH), f, /[ ,]+/)
+            key = (f[2] + 0) "," (f[4] + 0)
+            marks++
+            seen[key]++
+            if (seen[key] == 1) {
+                questions[f[2] + 0]++
+            }
+        }
+        /Changing exercise [0-9]+ rubric/ {
+            match($0, /exercise [0-9]+/)
+            updates[substr($0, RSTART + 9, RLENGTH - 9) + 0]++
+        }
+        /Semaphore operations:/ {
+            sem_ops = $3
+        }
+        END {
+            duplicates = 0
+            for (key in seen) {
+                duplicates += seen[key] - 1
+            }
+
+            n = split(expected, students, " ")
+            skipped = 0
+            incomplete = 0
+            completed = 0
+            for (i = 1; i <= n; i++) {
+                if (!(students[i] in questions)) {
+                    skipped++
+                } else if (questions[students[i]] < 5) {
+                    incomplete++
+                } else {
+                    completed++
+                }
+            }
+
+            split(initial, before, " ")
+            split(final, after, " ")
+            logged = 0
+            lost = 0
+            for (e = 1; e <= 5; e++) {
+                applied = (after[e] - before[e] + 256) % 256
+                logged += updates[e]
+                lost += updates[e] - applied
+            }
+
+            elapsed = end - start
+            printf "%-4s %6s %9.3f %9.2f %7d %6d %6d %6d %8d %6d %8s%s\n",
+                   label, seed, elapsed, completed / elapsed, marks, duplicates, skipped,
+                   incomplete, logged, lost, (sem_ops == "" ? "-" : sem_ops),
+                   (status == 124 ? "  (timed out)" : "")
+        }' "$log"
+}
+
+echo "======================================"
+echo "Part 2a vs 2b: $NUM_TAS TAs, delay scale $DELAY_SCALE, seeds $SEED..$((SEED + RUNS - 1))"
+echo "======================================"
+printf "%-4s %6s %9s %9s %7s %6s %6s %6s %8s %6s %8s\n" \
+       "part" "seed" "time(s)" "exams/s" "marks" "dupes" "skip" "incomp" "rub.upd" "lost" "semops"
+
+results=$(mktemp)
+for run in $(seq 0 $((RUNS - 1))); do
+    seed=$((SEED + run))
+    run_once 2a "$BINARY_2A" $seed output_2a.txt | tee -a "$results"
+    run_once 2b "$BINARY_2B" $seed output_2b.txt | tee -a "$results"
+done
+
+echo "--------------------------------------"
+awk '{
+        part = $1
+        runs[part]++
+        time[part] += $3
+        rate[part] += $4
+        dupes[part] += $6
+        skip[part] += $7
+        incomp[part] += $8
+        upd[part] += $9
+        lost[part] += $10
+        if ($11 != "-") {
+            semops[part] += $11
+        }
+    }
+    END {
+        for (part in runs) {
+            n = runs[part]
+            printf "%-4s %6s %9.3f %9.2f %7s %6.1f %6.1f %6.1f %8.1f %6.1f %8s\n",
+                   part, "mean", time[part] / n, rate[part] / n, "", dupes[part] / n,
+                   skip[part] / n, incomp[part] / n, upd[part] / n, lost[part] / n,
+                   (part in semops ? sprintf("%.0f", semops[part] / n) : "-")
+        }
+    }' "$results" | sort
+rm -f "$results"
+
+echo ""
+echo "Logs from the last run are in output_2a.txt and output_2b.txt"
+
+# Leave the test files in their initial state
+bash ./generate_test_files.sh > /dev/null 2>&1
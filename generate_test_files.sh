@@ -1,6 +1,9 @@
 #!/bin/bash
 
 # Script to generate test files for TA marking system
+# Usage: ./generate_test_files.sh [--priorities]
+#   --priorities  add "<priority>, <deadline>" lines to a few exams
+#                 (student 0015 is a deferred exam, 0012 and 0018 are appeals)
 
 echo "Generating rubric file..."
 cat > rubric.txt << EOF
@@ -23,6 +26,13 @@ for i in {1..20}; do
     echo "Created $filename"
 done
 
+if [ "$1" == "--priorities" ]; then
+    echo "5, 20" >> exam_0015.txt
+    echo "3, 40" >> exam_0012.txt
+    echo "3, 0" >> exam_0018.txt
+    echo "Added priority/deadline lines to exams 0012, 0015 and 0018"
+fi
+
 # Create the final exam file with student 9999 to signal end
 echo "9999" > exam_9999.txt
 echo "Created exam_9999.txt (end marker)"
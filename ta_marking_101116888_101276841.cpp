@@ -7,7 +7,8 @@
  * Each TA can read/modify the rubric and mark individual questions on exams.
  * 
  * Compile: g++ -o ta_marking ta_marking.cpp
- * Run: ./ta_marking <number_of_TAs>
+ * Run: ./ta_marking <number_of_TAs> [--placement=none|compact|scatter|node]
+ *                                   [--delay-scale=X] [--seed=N]
  */
 
 #include <iostream>
@@ -26,6 +27,7 @@
 #include <chrono>
 #include <thread>
 #include <iomanip>
+#include "ta_placement.h"
 
 // Constants
 #define NUM_EXERCISES 5
@@ -46,9 +48,16 @@ struct CurrentExam {
     int exam_index;  // Current exam being processed
 };
 
+// Multiplier applied to every simulated delay (set with --delay-scale)
+double delay_scale = 1.0;
+
+// Base random seed for the TAs (set with --seed, -1 = current time)
+long base_seed = -1;
+
 // Function to generate random delay between min and max seconds
 void random_delay(double min_sec, double max_sec) {
     double random_time = min_sec + (max_sec - min_sec) * ((double)rand() / RAND_MAX);
+    random_time *= delay_scale;
     int microseconds = (int)(random_time * 1000000);
     usleep(microseconds);
 }
@@ -122,7 +131,7 @@ bool all_questions_marked(CurrentExam* exam) {
 
 // TA process function
 void ta_process(int ta_id, Rubric* rubric, CurrentExam* exam) {
-    srand(time(NULL) + ta_id);  // Seed random number generator
+    srand((base_seed < 0 ? time(NULL) : base_seed) + ta_id);  // Seed random number generator
     
     std::cout << "[TA " << ta_id << "] Started working" << std::endl;
     
@@ -200,15 +209,16 @@ void ta_process(int ta_id, Rubric* rubric, CurrentExam* exam) {
         
         // If didn't mark anything (all questions taken), brief pause before trying again
         if (!marked_something) {
-            usleep(100000);  // 0.1 second
+            usleep((int)(100000 * delay_scale));  // 0.1 second, scaled by --delay-scale
         }
     }
 }
 
 int main(int argc, char* argv[]) {
     // Check command line arguments
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <number_of_TAs>" << std::endl;
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <number_of_TAs>"
+                  << " [--placement=none|compact|scatter|node] [--delay-scale=X] [--seed=N]" << std::endl;
         return 1;
     }
     
@@ -218,7 +228,43 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    // Parse optional arguments
+    PlacementPolicy placement = PLACEMENT_NONE;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 12, "--placement=") == 0) {
+            if (!parse_placement(arg.substr(12), &placement)) {
+                std::cerr << "Error: Unknown placement policy '" << arg.substr(12) << "'" << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 7, "--seed=") == 0) {
+            base_seed = atol(arg.c_str() + 7);
+            if (base_seed < 0) {
+                std::cerr << "Error: Seed must not be negative" << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 14, "--delay-scale=") == 0) {
+            delay_scale = atof(arg.c_str() + 14);
+            if (delay_scale < 0) {
+                std::cerr << "Error: Delay scale must not be negative" << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "Error: Unknown option '" << arg << "'" << std::endl;
+            return 1;
+        }
+    }
+    if (placement != PLACEMENT_NONE && !placement_supported()) {
+        std::cerr << "Warning: --placement=" << placement_name(placement)
+                  << " is unsupported on this platform, using none" << std::endl;
+        placement = PLACEMENT_NONE;
+    }
+    
     std::cout << "Starting TA marking system with " << num_tas << " TAs" << std::endl;
+    std::cout << "Placement policy: " << placement_name(placement) << std::endl;
+    
+    CpuTopology topology = read_cpu_topology();
+    int shm_node = home_node(topology, placement, num_tas);
     
     // Create shared memory for rubric
     int shm_rubric_id = shmget(IPC_PRIVATE, sizeof(Rubric), IPC_CREAT | 0666);
@@ -232,6 +278,7 @@ int main(int argc, char* argv[]) {
         std::cerr << "Error: Failed to attach shared memory for rubric" << std::endl;
         return 1;
     }
+    bind_shared_segment(rubric, sizeof(Rubric), shm_node);
     
     // Create shared memory for current exam
     int shm_exam_id = shmget(IPC_PRIVATE, sizeof(CurrentExam), IPC_CREAT | 0666);
@@ -245,6 +292,10 @@ int main(int argc, char* argv[]) {
         std::cerr << "Error: Failed to attach shared memory for exam" << std::endl;
         return 1;
     }
+    bind_shared_segment(exam, sizeof(CurrentExam), shm_node);
+    if (shm_node >= 0) {
+        std::cout << "Shared memory placed on NUMA node " << shm_node << std::endl;
+    }
     
     // Load initial rubric
     load_rubric(rubric);
@@ -267,6 +318,11 @@ int main(int argc, char* argv[]) {
             return 1;
         } else if (pid == 0) {
             // Child process (TA)
+            TaPlacement ta_cpus = place_ta(topology, placement, i, num_tas);
+            if (!ta_cpus.cpus.empty() && apply_ta_placement(ta_cpus)) {
+                std::cout << "[TA " << (i + 1) << "] Pinned to CPUs " << cpu_list_string(ta_cpus.cpus)
+                          << " (node " << ta_cpus.node << ")" << std::endl;
+            }
             ta_process(i + 1, rubric, exam);
             exit(0);
         } else {
@@ -0,0 +1,1048 @@
+/**
+ * @file ta_marking_coroutine.cpp
+ * @brief Assignment 3 Part 2b variant - TAs as C++20 coroutines on a thread pool
+ * @author Student Implementation
+ *
+ * Part 2b gives every TA its own process, which spends most of its life
+ * blocked in usleep() or semop(). This version runs each TA as a coroutine
+ * instead, multiplexed on a small pool of worker threads, so thousands of
+ * logical TAs fit in one process:
+ *
+ *   - Delays are awaitables handled by a timer thread
+ *   - The rubric reader-writer lock and the exam mutexes are awaitable locks;
+ *     a waiting TA is parked in a queue, not a blocked thread
+ *   - Exam reads and rubric writes are submitted through io_uring and the
+ *     TA is resumed when the completion arrives (falls back to blocking
+ *     read/write when io_uring is unavailable)
+ *
+ * The marking protocol is the same as Part 2b: review the rubric as a reader,
+ * upgrade to a writer to correct it, claim one question at a time, and load
+ * the next exam when all questions are marked.
+ *
+ * Compile: g++ -std=c++20 -pthread -o ta_marking_coroutine ta_marking_coroutine.cpp
+ * Run: ./ta_marking_coroutine <number_of_TAs> [--threads=N] [--delay-scale=X] [--verbose]
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <queue>
+#include <set>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <cerrno>
+#include <iomanip>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+// Constants
+#define NUM_EXERCISES 5
+#define END_STUDENT 9999
+#define RUBRIC_FILE "rubric.txt"
+#define EXAM_PREFIX "exam_"
+#define EXAM_SUFFIX ".txt"
+#define RING_ENTRIES 256
+#define FILE_BUFFER_SIZE 4096
+
+// Multiplier applied to every simulated delay (set with --delay-scale)
+double delay_scale = 1.0;
+
+// Print per-TA progress messages (set with --verbose)
+bool verbose = false;
+
+std::mutex log_mutex;
+
+// Function to print one progress line without interleaving
+void log_line(const std::string& line) {
+    std::lock_guard<std::mutex> guard(log_mutex);
+    std::cout << line << std::endl;
+}
+
+#define TA_LOG(ta_id, message)                                  \
+    do {                                                        \
+        if (verbose) {                                          \
+            std::stringstream log_ss;                           \
+            log_ss << "[TA " << (ta_id) << "] " << message;     \
+            log_line(log_ss.str());                             \
+        }                                                       \
+    } while (0)
+
+// Same layout as the Part 2b shared memory structures
+struct Rubric {
+    char exercises[NUM_EXERCISES][100];
+};
+
+struct CurrentExam {
+    int student_number;
+    bool questions_marked[NUM_EXERCISES];
+    int exam_index;
+    bool being_marked[NUM_EXERCISES];
+};
+
+// Coroutine type for one TA. The frame starts suspended so the scheduler
+// decides which worker thread runs it, and frees itself when the TA returns.
+struct TaTask {
+    struct promise_type {
+        TaTask get_return_object() {
+            return TaTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Thread pool that resumes ready coroutines, plus a timer thread for delays
+class Scheduler {
+public:
+    explicit Scheduler(int num_threads) : num_threads(num_threads), stopping(false) {}
+
+    void start() {
+        for (int i = 0; i < num_threads; i++) {
+            workers.emplace_back(&Scheduler::worker_loop, this);
+        }
+        timer_thread = std::thread(&Scheduler::timer_loop, this);
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> run_guard(run_mutex);
+            std::lock_guard<std::mutex> timer_guard(timer_mutex);
+            stopping = true;
+        }
+        run_cv.notify_all();
+        timer_cv.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        timer_thread.join();
+    }
+
+    // Function to make a coroutine runnable on the pool
+    void schedule(std::coroutine_handle<> handle) {
+        {
+            std::lock_guard<std::mutex> guard(run_mutex);
+            run_queue.push_back(handle);
+        }
+        run_cv.notify_one();
+    }
+
+    // Function to make a coroutine runnable after a delay
+    void schedule_after(double seconds, std::coroutine_handle<> handle) {
+        Timer timer;
+        timer.due = std::chrono::steady_clock::now() +
+                    std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(seconds));
+        timer.handle = handle;
+        {
+            std::lock_guard<std::mutex> guard(timer_mutex);
+            timers.push(timer);
+        }
+        timer_cv.notify_one();
+    }
+
+private:
+    struct Timer {
+        std::chrono::steady_clock::time_point due;
+        std::coroutine_handle<> handle;
+        bool operator>(const Timer& other) const { return due > other.due; }
+    };
+
+    void worker_loop() {
+        while (true) {
+            std::coroutine_handle<> handle;
+            {
+                std::unique_lock<std::mutex> lock(run_mutex);
+                run_cv.wait(lock, [this] { return stopping || !run_queue.empty(); });
+                if (run_queue.empty()) {
+                    return;
+                }
+                handle = run_queue.front();
+                run_queue.pop_front();
+            }
+            handle.resume();
+        }
+    }
+
+    void timer_loop() {
+        std::unique_lock<std::mutex> lock(timer_mutex);
+        while (!stopping) {
+            if (timers.empty()) {
+                timer_cv.wait(lock);
+                continue;
+            }
+            std::chrono::steady_clock::time_point due = timers.top().due;
+            if (std::chrono::steady_clock::now() < due) {
+                timer_cv.wait_until(lock, due);
+                continue;
+            }
+            std::coroutine_handle<> handle = timers.top().handle;
+            timers.pop();
+            lock.unlock();
+            schedule(handle);
+            lock.lock();
+        }
+    }
+
+    int num_threads;
+    bool stopping;
+
+    std::mutex run_mutex;
+    std::condition_variable run_cv;
+    std::deque<std::coroutine_handle<> > run_queue;
+    std::vector<std::thread> workers;
+
+    std::mutex timer_mutex;
+    std::condition_variable timer_cv;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer> > timers;
+    std::thread timer_thread;
+};
+
+// Awaitable delay: the TA is parked on the timer queue, not in usleep()
+struct SleepAwaiter {
+    Scheduler& scheduler;
+    double seconds;
+
+    bool await_ready() const { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        if (seconds <= 0) {
+            scheduler.schedule(handle);
+        } else {
+            scheduler.schedule_after(seconds, handle);
+        }
+    }
+    void await_resume() {}
+};
+
+// Awaitable mutex; unlock() hands ownership straight to the next waiter
+class AsyncMutex {
+public:
+    explicit AsyncMutex(Scheduler& scheduler) : scheduler(scheduler), locked(false) {}
+
+    struct LockAwaiter {
+        AsyncMutex& mutex;
+
+        bool await_ready() const { return false; }
+        bool await_suspend(std::coroutine_handle<> handle) {
+            std::lock_guard<std::mutex> guard(mutex.state_mutex);
+            if (!mutex.locked) {
+                mutex.locked = true;
+                return false;
+            }
+            mutex.waiters.push_back(handle);
+            return true;
+        }
+        void await_resume() {}
+    };
+
+    LockAwaiter lock() { return LockAwaiter{*this}; }
+
+    void unlock() {
+        std::coroutine_handle<> next;
+        {
+            std::lock_guard<std::mutex> guard(state_mutex);
+            if (waiters.empty()) {
+                locked = false;
+                return;
+            }
+            next = waiters.front();
+            waiters.pop_front();
+        }
+        scheduler.schedule(next);
+    }
+
+private:
+    Scheduler& scheduler;
+    std::mutex state_mutex;
+    bool locked;
+    std::deque<std::coroutine_handle<> > waiters;
+};
+
+// Awaitable reader-writer lock for the rubric. Waiters are admitted in
+// arrival order, so a steady stream of readers cannot starve a writer
+// even with thousands of TAs reviewing at once.
+class AsyncRWLock {
+public:
+    explicit AsyncRWLock(Scheduler& scheduler)
+        : scheduler(scheduler), readers(0), writer(false) {}
+
+    struct ReadAwaiter {
+        AsyncRWLock& lock;
+
+        bool await_ready() const { return false; }
+        bool await_suspend(std::coroutine_handle<> handle) {
+            std::lock_guard<std::mutex> guard(lock.state_mutex);
+            if (!lock.writer && lock.waiters.empty()) {
+                lock.readers++;
+                return false;
+            }
+            lock.waiters.push_back(Waiter{handle, false});
+            return true;
+        }
+        void await_resume() {}
+    };
+
+    struct WriteAwaiter {
+        AsyncRWLock& lock;
+
+        bool await_ready() const { return false; }
+        bool await_suspend(std::coroutine_handle<> handle) {
+            std::lock_guard<std::mutex> guard(lock.state_mutex);
+            if (!lock.writer && lock.readers == 0 && lock.waiters.empty()) {
+                lock.writer = true;
+                return false;
+            }
+            lock.waiters.push_back(Waiter{handle, true});
+            return true;
+        }
+        void await_resume() {}
+    };
+
+    ReadAwaiter read_lock() { return ReadAwaiter{*this}; }
+    WriteAwaiter write_lock() { return WriteAwaiter{*this}; }
+
+    void read_unlock() {
+        std::vector<std::coroutine_handle<> > wake;
+        {
+            std::lock_guard<std::mutex> guard(state_mutex);
+            readers--;
+            if (readers == 0) {
+                admit_waiters(wake);
+            }
+        }
+        for (std::coroutine_handle<> handle : wake) {
+            scheduler.schedule(handle);
+        }
+    }
+
+    void write_unlock() {
+        std::vector<std::coroutine_handle<> > wake;
+        {
+            std::lock_guard<std::mutex> guard(state_mutex);
+            writer = false;
+            admit_waiters(wake);
+        }
+        for (std::coroutine_handle<> handle : wake) {
+            scheduler.schedule(handle);
+        }
+    }
+
+private:
+    struct Waiter {
+        std::coroutine_handle<> handle;
+        bool is_writer;
+    };
+
+    // Called with no holders: wake one writer or the leading run of readers
+    void admit_waiters(std::vector<std::coroutine_handle<> >& wake) {
+        if (!waiters.empty() && waiters.front().is_writer) {
+            writer = true;
+            wake.push_back(waiters.front().handle);
+            waiters.pop_front();
+            return;
+        }
+        while (!waiters.empty() && !waiters.front().is_writer) {
+            readers++;
+            wake.push_back(waiters.front().handle);
+            waiters.pop_front();
+        }
+    }
+
+    Scheduler& scheduler;
+    std::mutex state_mutex;
+    int readers;
+    bool writer;
+    std::deque<Waiter> waiters;
+};
+
+// Function to read or write a whole file with blocking system calls;
+// returns the byte count or -errno
+long blocking_file_io(const std::string& path, bool writing, std::string* data) {
+    int fd = writing ? open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)
+                     : open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return -errno;
+    }
+    long n;
+    if (writing) {
+        n = write(fd, data->data(), data->size());
+    } else {
+        data->resize(FILE_BUFFER_SIZE);
+        n = read(fd, &(*data)[0], data->size());
+        data->resize(n > 0 ? n : 0);
+    }
+    if (n < 0) {
+        n = -errno;
+    }
+    close(fd);
+    return n;
+}
+
+// One file operation handed to the ring. It owns its fd and buffer rather
+// than borrowing the caller's, so an operation the kernel may still be
+// working on can be abandoned without the caller freeing memory under it.
+struct FileOp {
+    int fd;
+    std::vector<char> buffer;
+    long result;
+    bool kernel_owned;               // Never reaped; must not be freed
+    std::coroutine_handle<> handle;
+};
+
+// Minimal io_uring wrapper over the raw system calls (no liburing needed).
+// Submissions come from any worker thread; one completion thread reaps
+// CQEs and reschedules the waiting coroutine. Whenever the ring cannot
+// take an operation, the awaiter falls back to a blocking read/write.
+class IoRing {
+public:
+    explicit IoRing(Scheduler& scheduler)
+        : scheduler(scheduler), ring_fd(-1), sq_ptr(NULL), cq_ptr(NULL), sqes(NULL),
+          sq_ring_size(0), cq_ring_size(0), sqes_size(0), usable(false), stopping(false),
+          reaping(false) {}
+
+    ~IoRing() {
+        if (sqes != NULL) {
+            munmap(sqes, sqes_size);
+        }
+        if (cq_ptr != NULL && cq_ptr != sq_ptr) {
+            munmap(cq_ptr, cq_ring_size);
+        }
+        if (sq_ptr != NULL) {
+            munmap(sq_ptr, sq_ring_size);
+        }
+        if (ring_fd >= 0) {
+            close(ring_fd);
+        }
+    }
+
+    // Function to set up the ring; returns false if io_uring is unavailable
+    // or the kernel lacks IORING_OP_READ/IORING_OP_WRITE (added in 5.6)
+    bool start() {
+        struct io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        ring_fd = (int)syscall(__NR_io_uring_setup, RING_ENTRIES, &params);
+        if (ring_fd < 0) {
+            return false;
+        }
+        if (!supports_read_write()) {
+            return false;
+        }
+
+        sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            sq_ring_size = std::max(sq_ring_size, cq_ring_size);
+            cq_ring_size = sq_ring_size;
+        }
+
+        sq_ptr = mmap(NULL, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring_fd, IORING_OFF_SQ_RING);
+        if (sq_ptr == MAP_FAILED) {
+            sq_ptr = NULL;
+            return false;
+        }
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            cq_ptr = sq_ptr;
+        } else {
+            cq_ptr = mmap(NULL, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          ring_fd, IORING_OFF_CQ_RING);
+            if (cq_ptr == MAP_FAILED) {
+                cq_ptr = NULL;
+                return false;
+            }
+        }
+        sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+        sqes = (struct io_uring_sqe*)mmap(NULL, sqes_size, PROT_READ | PROT_WRITE,
+                                          MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            sqes = NULL;
+            return false;
+        }
+
+        char* sq = (char*)sq_ptr;
+        char* cq = (char*)cq_ptr;
+        sq_tail = (unsigned*)(sq + params.sq_off.tail);
+        sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+        sq_array = (unsigned*)(sq + params.sq_off.array);
+        cq_head = (unsigned*)(cq + params.cq_off.head);
+        cq_tail = (unsigned*)(cq + params.cq_off.tail);
+        cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+        cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+        usable = true;
+        reaping = true;
+        completion_thread = std::thread(&IoRing::completion_loop, this);
+        return true;
+    }
+
+    void stop() {
+        if (!completion_thread.joinable()) {
+            return;
+        }
+        stopping = true;
+        // A NOP with no owner wakes the completion thread so it can exit
+        if (reaping) {
+            std::lock_guard<std::mutex> guard(submit_mutex);
+            if (!push_sqe(IORING_OP_NOP, -1, NULL, 0, 0)) {
+                perror("io_uring_enter failed on shutdown");
+            }
+        }
+        completion_thread.join();
+    }
+
+    // Function to stop using the ring for new operations
+    void disable(const char* reason) {
+        bool was_usable = usable.exchange(false);
+        if (was_usable) {
+            log_line(std::string("io_uring disabled (") + reason + "), using blocking read/write");
+        }
+    }
+
+    // Awaitable whole-file read or write through the ring
+    struct FileAwaiter {
+        IoRing& ring;
+        std::string path;
+        std::string* data;
+        bool writing;
+        FileOp* op;
+        long result;
+
+        bool await_ready() const { return false; }
+
+        bool await_suspend(std::coroutine_handle<> h) {
+            if (ring.usable) {
+                int fd = writing ? open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)
+                                 : open(path.c_str(), O_RDONLY);
+                if (fd < 0) {
+                    result = -errno;
+                    return false;
+                }
+                op = new FileOp{fd, std::vector<char>(), 0, false, h};
+                if (writing) {
+                    op->buffer.assign(data->begin(), data->end());
+                } else {
+                    op->buffer.resize(FILE_BUFFER_SIZE);
+                }
+                // The completion may resume us on another thread before
+                // submit() returns, so nothing may touch *this afterwards
+                if (ring.submit(op, writing)) {
+                    return true;
+                }
+                close(op->fd);
+                delete op;
+                op = NULL;
+            }
+            result = blocking_file_io(path, writing, data);
+            return false;
+        }
+
+        bool await_resume() {
+            if (op == NULL) {
+                return result >= 0;
+            }
+            result = op->result;
+            if (result >= 0 && !writing) {
+                data->assign(op->buffer.begin(), op->buffer.begin() + result);
+            }
+            if (!op->kernel_owned) {
+                close(op->fd);
+                delete op;
+            }
+            op = NULL;
+
+            if (result < 0) {
+                // The ring could not complete it: redo it synchronously
+                if (result == -EINVAL || result == -EOPNOTSUPP) {
+                    ring.disable("operation rejected by the kernel");
+                }
+                result = blocking_file_io(path, writing, data);
+            }
+            return result >= 0;
+        }
+    };
+
+    FileAwaiter read_file(const std::string& path, std::string* data) {
+        return FileAwaiter{*this, path, data, false, NULL, 0};
+    }
+
+    FileAwaiter write_file(const std::string& path, std::string* data) {
+        return FileAwaiter{*this, path, data, true, NULL, 0};
+    }
+
+private:
+    // Function to check the kernel supports the opcodes used by FileAwaiter
+    bool supports_read_write() {
+        const unsigned num_ops = 256;
+        std::vector<char> buffer(sizeof(struct io_uring_probe) +
+                                 num_ops * sizeof(struct io_uring_probe_op), 0);
+        struct io_uring_probe* probe = (struct io_uring_probe*)&buffer[0];
+        if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PROBE, probe, num_ops) < 0) {
+            return false;
+        }
+        return probe->last_op >= IORING_OP_WRITE &&
+               (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) &&
+               (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED);
+    }
+
+    // Function to submit a file operation; false means do it synchronously
+    bool submit(FileOp* op, bool writing) {
+        std::lock_guard<std::mutex> guard(submit_mutex);
+        if (!usable) {
+            return false;
+        }
+        in_flight.insert(op);
+        bool submitted = push_sqe(writing ? IORING_OP_WRITE : IORING_OP_READ, op->fd,
+                                  op->buffer.data(), (unsigned)op->buffer.size(),
+                                  (unsigned long long)(uintptr_t)op);
+        if (!submitted) {
+            perror("io_uring_enter failed");
+            in_flight.erase(op);
+        }
+        return submitted;
+    }
+
+    // Function to queue one SQE and enter the kernel (submit_mutex held).
+    // On failure the SQE is withdrawn so it can never complete later.
+    bool push_sqe(int opcode, int fd, void* buffer, unsigned length, unsigned long long user_data) {
+        unsigned tail = *sq_tail;
+        unsigned index = tail & *sq_mask;
+        struct io_uring_sqe* sqe = &sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = opcode;
+        sqe->fd = fd;
+        sqe->addr = (unsigned long long)(uintptr_t)buffer;
+        sqe->len = length;
+        sqe->off = 0;
+        sqe->user_data = user_data;
+        sq_array[index] = index;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+        long ret;
+        do {
+            ret = syscall(__NR_io_uring_enter, ring_fd, 1, 0, 0, NULL, 0);
+        } while (ret < 0 && errno == EINTR);
+        if (ret < 1) {
+            // Without SQPOLL the kernel only reads the SQ inside io_uring_enter
+            __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+            if (ret == 0) {
+                errno = EAGAIN;
+            }
+            return false;
+        }
+        return true;
+    }
+
+    // Function to resume every waiting coroutine with an error. The kernel
+    // may still complete these operations, so they are marked kernel-owned
+    // and their fd and buffer are deliberately never released.
+    void fail_in_flight(int error) {
+        std::set<FileOp*> failed;
+        {
+            std::lock_guard<std::mutex> guard(submit_mutex);
+            usable = false;
+            reaping = false;
+            failed.swap(in_flight);
+        }
+        for (FileOp* op : failed) {
+            op->kernel_owned = true;
+            op->result = -error;
+            scheduler.schedule(op->handle);
+        }
+    }
+
+    void completion_loop() {
+        while (true) {
+            if (syscall(__NR_io_uring_enter, ring_fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 &&
+                errno != EINTR) {
+                int error = errno;
+                perror("io_uring_enter failed while waiting for completions");
+                log_line("io_uring disabled, retrying pending file operations with blocking I/O");
+                fail_in_flight(error);
+                return;
+            }
+
+            unsigned head = *cq_head;
+            unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+            while (head != tail) {
+                struct io_uring_cqe* cqe = &cqes[head & *cq_mask];
+                FileOp* op = (FileOp*)(uintptr_t)cqe->user_data;
+                if (op != NULL) {
+                    {
+                        std::lock_guard<std::mutex> guard(submit_mutex);
+                        in_flight.erase(op);
+                    }
+                    op->result = cqe->res;
+                    scheduler.schedule(op->handle);
+                }
+                head++;
+            }
+            __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+
+            if (stopping) {
+                return;
+            }
+        }
+    }
+
+    Scheduler& scheduler;
+    int ring_fd;
+    void* sq_ptr;
+    void* cq_ptr;
+    struct io_uring_sqe* sqes;
+    size_t sq_ring_size;
+    size_t cq_ring_size;
+    size_t sqes_size;
+
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_cqe* cqes;
+
+    std::mutex submit_mutex;
+    std::set<FileOp*> in_flight;       // Submitted, completion not yet reaped
+    std::thread completion_thread;
+    std::atomic<bool> usable;
+    std::atomic<bool> stopping;
+    std::atomic<bool> reaping;         // Completion thread still running
+};
+
+// Everything the TAs share, plus counters for the final summary
+struct Marking {
+    Scheduler& scheduler;
+    IoRing& ring;
+    AsyncRWLock rubric_lock;
+    AsyncMutex exam_mutex;
+    AsyncMutex loading_mutex;
+    Rubric rubric;
+    CurrentExam exam;
+
+    std::atomic<int> exams_loaded;
+    std::atomic<int> questions_marked;
+    std::atomic<int> rubric_corrections;
+
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+    int tas_running;
+
+    Marking(Scheduler& scheduler, IoRing& ring, int num_tas)
+        : scheduler(scheduler), ring(ring), rubric_lock(scheduler), exam_mutex(scheduler),
+          loading_mutex(scheduler), exams_loaded(0), questions_marked(0),
+          rubric_corrections(0), tas_running(num_tas) {}
+
+    void ta_finished() {
+        std::lock_guard<std::mutex> guard(done_mutex);
+        if (--tas_running == 0) {
+            done_cv.notify_all();
+        }
+    }
+
+    void wait_for_tas() {
+        std::unique_lock<std::mutex> lock(done_mutex);
+        done_cv.wait(lock, [this] { return tas_running == 0; });
+    }
+};
+
+// Function to await a random delay between min and max seconds
+SleepAwaiter random_delay(Scheduler& scheduler, unsigned* seed, double min_sec, double max_sec) {
+    double random_time = min_sec + (max_sec - min_sec) * ((double)rand_r(seed) / RAND_MAX);
+    return SleepAwaiter{scheduler, random_time * delay_scale};
+}
+
+// Function to build an exam file name from its index
+std::string exam_filename(int exam_index) {
+    std::stringstream ss;
+    ss << EXAM_PREFIX << std::setfill('0') << std::setw(4) << exam_index << EXAM_SUFFIX;
+    return ss.str();
+}
+
+// Function to load exam file contents into the current exam
+bool parse_exam(const std::string& contents, CurrentExam* exam, int exam_index) {
+    std::stringstream ss(contents);
+    std::string line;
+    if (!std::getline(ss, line) || line.empty()) {
+        return false;
+    }
+    exam->student_number = atoi(line.c_str());
+    exam->exam_index = exam_index;
+    for (int i = 0; i < NUM_EXERCISES; i++) {
+        exam->questions_marked[i] = false;
+        exam->being_marked[i] = false;
+    }
+    return true;
+}
+
+// Function to load rubric from file
+void load_rubric(Rubric* rubric) {
+    std::ifstream file(RUBRIC_FILE);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open rubric file" << std::endl;
+        return;
+    }
+
+    std::string line;
+    int index = 0;
+    while (std::getline(file, line) && index < NUM_EXERCISES) {
+        strncpy(rubric->exercises[index], line.c_str(), 99);
+        rubric->exercises[index][99] = '\0';
+        index++;
+    }
+    file.close();
+}
+
+// Function to format the rubric the way save_rubric() writes it
+std::string rubric_text(const Rubric* rubric) {
+    std::string text;
+    for (int i = 0; i < NUM_EXERCISES; i++) {
+        text += rubric->exercises[i];
+        text += "\n";
+    }
+    return text;
+}
+
+// Function to check if all questions are marked
+bool all_questions_marked(const CurrentExam* exam) {
+    for (int i = 0; i < NUM_EXERCISES; i++) {
+        if (!exam->questions_marked[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Function to pick the corrected rubric letter. Large teams make hundreds of
+// corrections per exercise, so letters cycle through 'A'..'Z' rather than
+// running past the printable range into the shared rubric.txt.
+char next_rubric_letter(char letter) {
+    return (letter >= 'A' && letter < 'Z') ? letter + 1 : 'A';
+}
+
+// TA coroutine: same protocol as the Part 2b TA process
+TaTask ta_coroutine(int ta_id, Marking& m) {
+    unsigned seed = time(NULL) + ta_id;
+
+    TA_LOG(ta_id, "===== STARTED WORKING =====");
+
+    while (true) {
+        co_await m.exam_mutex.lock();
+        int current_student = m.exam.student_number;
+        m.exam_mutex.unlock();
+
+        if (current_student == END_STUDENT) {
+            TA_LOG(ta_id, "===== FINISHED - reached student 9999 =====");
+            break;
+        }
+
+        // Review rubric as a reader, upgrading to a writer for corrections
+        co_await m.rubric_lock.read_lock();
+        TA_LOG(ta_id, "ENTERED rubric read critical section for exam " << current_student);
+
+        for (int i = 0; i < NUM_EXERCISES; i++) {
+            co_await random_delay(m.scheduler, &seed, 0.5, 1.0);
+
+            if ((rand_r(&seed) % 100) < 30) {
+                m.rubric_lock.read_unlock();
+                co_await m.rubric_lock.write_lock();
+
+                char* comma = strchr(m.rubric.exercises[i], ',');
+                if (comma != NULL && *(comma + 1) == ' ') {
+                    char& rubric_char = *(comma + 2);
+                    char corrected = next_rubric_letter(rubric_char);
+                    TA_LOG(ta_id, "WRITING: Changing exercise " << (i + 1) << " rubric from '"
+                           << rubric_char << "' to '" << corrected << "'");
+                    rubric_char = corrected;
+                    m.rubric_corrections++;
+
+                    std::string text = rubric_text(&m.rubric);
+                    bool saved = co_await m.ring.write_file(RUBRIC_FILE, &text);
+                    if (!saved) {
+                        log_line("Error: Could not save rubric file");
+                    }
+                }
+
+                m.rubric_lock.write_unlock();
+                co_await m.rubric_lock.read_lock();
+            }
+        }
+
+        m.rubric_lock.read_unlock();
+        TA_LOG(ta_id, "<<< COMPLETED rubric review");
+
+        // Claim and mark one question
+        co_await m.exam_mutex.lock();
+        int question = -1;
+        for (int q = 0; q < NUM_EXERCISES; q++) {
+            if (!m.exam.questions_marked[q] && !m.exam.being_marked[q]) {
+                m.exam.being_marked[q] = true;
+                question = q;
+                break;
+            }
+        }
+        int student = m.exam.student_number;
+        bool all_marked = all_questions_marked(&m.exam);
+        m.exam_mutex.unlock();
+
+        if (question >= 0) {
+            TA_LOG(ta_id, "MARKING student " << student << ", question " << (question + 1));
+            co_await random_delay(m.scheduler, &seed, 1.0, 2.0);
+
+            co_await m.exam_mutex.lock();
+            m.exam.questions_marked[question] = true;
+            m.exam.being_marked[question] = false;
+            m.exam_mutex.unlock();
+            m.questions_marked++;
+
+            TA_LOG(ta_id, "COMPLETED marking student " << student << ", question " << (question + 1));
+            continue;
+        }
+
+        if (!all_marked) {
+            // Brief pause before trying again
+            co_await SleepAwaiter{m.scheduler, 0.1 * delay_scale};
+            continue;
+        }
+
+        // Load next exam (only one TA does this)
+        co_await m.loading_mutex.lock();
+
+        co_await m.exam_mutex.lock();
+        bool still_marked = all_questions_marked(&m.exam) && m.exam.student_number != END_STUDENT;
+        int next_exam_index = m.exam.exam_index + 1;
+        m.exam_mutex.unlock();
+
+        if (still_marked) {
+            TA_LOG(ta_id, "LOADING next exam (index " << next_exam_index << ")...");
+            std::string contents;
+            bool loaded = co_await m.ring.read_file(exam_filename(next_exam_index), &contents);
+
+            co_await m.exam_mutex.lock();
+            if (!loaded || !parse_exam(contents, &m.exam, next_exam_index)) {
+                TA_LOG(ta_id, "No more exams to load");
+                m.exam.student_number = END_STUDENT;
+            } else {
+                m.exams_loaded++;
+                TA_LOG(ta_id, "LOADED exam for student " << m.exam.student_number);
+            }
+            m.exam_mutex.unlock();
+        }
+
+        m.loading_mutex.unlock();
+    }
+
+    m.ta_finished();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <number_of_TAs>"
+                  << " [--threads=N] [--delay-scale=X] [--verbose]" << std::endl;
+        return 1;
+    }
+
+    int num_tas = atoi(argv[1]);
+    if (num_tas < 2) {
+        std::cerr << "Error: Number of TAs must be at least 2" << std::endl;
+        return 1;
+    }
+
+    // Parse optional arguments
+    int num_threads = (int)std::thread::hardware_concurrency();
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 10, "--threads=") == 0) {
+            num_threads = atoi(arg.c_str() + 10);
+            if (num_threads < 1) {
+                std::cerr << "Error: Number of threads must be at least 1" << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 14, "--delay-scale=") == 0) {
+            delay_scale = atof(arg.c_str() + 14);
+            if (delay_scale < 0) {
+                std::cerr << "Error: Delay scale must not be negative" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--verbose") {
+            verbose = true;
+        } else {
+            std::cerr << "Error: Unknown option '" << arg << "'" << std::endl;
+            return 1;
+        }
+    }
+
+    Scheduler scheduler(num_threads);
+    IoRing ring(scheduler);
+    bool uring = ring.start();
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "Starting TA marking system with " << num_tas << " TAs" << std::endl;
+    std::cout << "COROUTINES on " << num_threads << " worker thread(s), file I/O via "
+              << (uring ? "io_uring" : "blocking read/write (io_uring unavailable)") << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    Marking marking(scheduler, ring, num_tas);
+    load_rubric(&marking.rubric);
+    std::cout << "Loaded rubric" << std::endl;
+
+    std::ifstream first(exam_filename(1));
+    std::stringstream contents;
+    contents << first.rdbuf();
+    if (!first.is_open() || !parse_exam(contents.str(), &marking.exam, 1)) {
+        std::cerr << "Error: Could not load first exam (exam_0001.txt)" << std::endl;
+        return 1;
+    }
+    marking.exams_loaded = 1;
+    std::cout << "Loaded first exam (student " << marking.exam.student_number << ")" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Create TA coroutines and hand them to the pool
+    scheduler.start();
+    for (int i = 0; i < num_tas; i++) {
+        scheduler.schedule(ta_coroutine(i + 1, marking).handle);
+    }
+
+    marking.wait_for_tas();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    scheduler.stop();
+    ring.stop();
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "All TAs have finished marking" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Exams marked:        " << marking.exams_loaded << std::endl;
+    std::cout << "Questions marked:    " << marking.questions_marked << std::endl;
+    std::cout << "Rubric corrections:  " << marking.rubric_corrections << std::endl;
+    std::cout << "Elapsed time:        " << std::fixed << std::setprecision(2) << elapsed << "s" << std::endl;
+    std::cout << "Peak memory (RSS):   " << usage.ru_maxrss << " KB" << std::endl;
+
+    return 0;
+}
@@ -7,7 +7,13 @@
  * to eliminate race conditions and ensure proper coordination between TAs.
  * 
  * Compile: g++ -o ta_marking_semaphore ta_marking_semaphore.cpp
- * Run: ./ta_marking_semaphore <number_of_TAs>
+ * Run: ./ta_marking_semaphore <number_of_TAs> [--placement=none|compact|scatter|node]
+ *                                             [--delay-scale=X] [--seed=N]
+ *                                             [--schedule=fifo|priority|deadline]
+ *
+ * Exam files may carry an optional second line "<priority>, <deadline>":
+ * a larger priority is marked sooner, and the deadline is in seconds after
+ * start (0 means no deadline). Files without it default to "0, 0".
  */
 
 #include <iostream>
@@ -25,9 +31,12 @@
 #include <cstdlib>
 #include <ctime>
 #include <iomanip>
+#include <algorithm>
+#include "ta_placement.h"
 
 // Constants
 #define NUM_EXERCISES 5
+#define END_STUDENT 9999
 #define RUBRIC_FILE "rubric.txt"
 #define EXAM_PREFIX "exam_"
 #define EXAM_SUFFIX ".txt"
@@ -64,12 +73,88 @@ struct CurrentExam {
     bool being_marked[NUM_EXERCISES];  // Track which questions are being marked
 };
 
+// Order in which pending exams are handed to the TAs
+enum SchedulePolicy {
+    SCHEDULE_FIFO,      // exam_index order (original behaviour)
+    SCHEDULE_PRIORITY,  // highest priority first
+    SCHEDULE_DEADLINE   // earliest deadline first
+};
+
+// Function to parse a schedule policy name
+bool parse_schedule(const std::string& name, SchedulePolicy* policy) {
+    if (name == "fifo") {
+        *policy = SCHEDULE_FIFO;
+    } else if (name == "priority") {
+        *policy = SCHEDULE_PRIORITY;
+    } else if (name == "deadline") {
+        *policy = SCHEDULE_DEADLINE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* schedule_name(SchedulePolicy policy) {
+    switch (policy) {
+        case SCHEDULE_PRIORITY: return "priority";
+        case SCHEDULE_DEADLINE: return "deadline";
+        default:                return "fifo";
+    }
+}
+
+// One exam waiting in (or taken from) the queue; times are CLOCK_MONOTONIC seconds
+struct PendingExam {
+    int exam_index;
+    int student_number;
+    int priority;
+    double deadline;     // Seconds after start, 0 = none
+    double queued_at;
+    double started_at;   // Loaded as the current exam
+    double finished_at;  // Last question marked
+    bool skipped;        // File could not be read when its turn came
+};
+
+// Shared memory priority queue of exams (binary heap of slots)
+// Protected by SEM_EXAM_MUTEX. The segment is sized for the exam files found
+// at start-up: this header is followed by PendingExam[capacity] and then the
+// heap's int[capacity]; use queue_exams() and queue_heap() to reach them.
+struct ExamQueue {
+    int capacity;
+    int count;            // Slots used in the exam array
+    int heap_size;
+    int current;          // Slot of the exam in CurrentExam, -1 if none
+    int policy;
+    double start_time;
+    long sem_ops;         // semop() calls made by all TAs
+};
+
+// Function to compute the shared memory size of a queue for capacity exams
+size_t exam_queue_size(int capacity) {
+    return sizeof(ExamQueue) + capacity * (sizeof(PendingExam) + sizeof(int));
+}
+
+PendingExam* queue_exams(ExamQueue* queue) {
+    return (PendingExam*)(queue + 1);
+}
+
+const PendingExam* queue_exams(const ExamQueue* queue) {
+    return (const PendingExam*)(queue + 1);
+}
+
+int* queue_heap(ExamQueue* queue) {
+    return (int*)(queue_exams(queue) + queue->capacity);
+}
+
+// semop() calls made by this process, added to the exam queue on exit
+long sem_ops = 0;
+
 // Semaphore operation helper functions
 void sem_wait(int semid, int sem_num) {
     struct sembuf op;
     op.sem_num = sem_num;
     op.sem_op = -1;  // Wait (decrement)
     op.sem_flg = 0;
+    sem_ops++;
     
     if (semop(semid, &op, 1) == -1) {
         perror("sem_wait failed");
@@ -82,6 +167,7 @@ void sem_signal(int semid, int sem_num) {
     op.sem_num = sem_num;
     op.sem_op = 1;  // Signal (increment)
     op.sem_flg = 0;
+    sem_ops++;
     
     if (semop(semid, &op, 1) == -1) {
         perror("sem_signal failed");
@@ -89,9 +175,16 @@ void sem_signal(int semid, int sem_num) {
     }
 }
 
+// Multiplier applied to every simulated delay (set with --delay-scale)
+double delay_scale = 1.0;
+
+// Base random seed for the TAs (set with --seed, -1 = current time)
+long base_seed = -1;
+
 // Function to generate random delay between min and max seconds
 void random_delay(double min_sec, double max_sec) {
     double random_time = min_sec + (max_sec - min_sec) * ((double)rand() / RAND_MAX);
+    random_time *= delay_scale;
     int microseconds = (int)(random_time * 1000000);
     usleep(microseconds);
 }
@@ -153,6 +246,211 @@ bool load_exam(CurrentExam* exam, int exam_index) {
     return true;
 }
 
+// Function to read the monotonic clock in seconds
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Function to read an exam file's student number and scheduling fields
+bool read_exam_file(int exam_index, PendingExam* pending) {
+    std::stringstream ss;
+    ss << EXAM_PREFIX << std::setfill('0') << std::setw(4) << exam_index << EXAM_SUFFIX;
+    
+    std::ifstream file(ss.str());
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    std::string line;
+    if (!std::getline(file, line)) {
+        return false;
+    }
+    pending->exam_index = exam_index;
+    pending->student_number = std::stoi(line);
+    pending->priority = 0;
+    pending->deadline = 0;
+    
+    // Optional "<priority>, <deadline>" line
+    if (std::getline(file, line)) {
+        size_t comma = line.find(',');
+        if (comma != std::string::npos) {
+            pending->priority = atoi(line.c_str());
+            pending->deadline = atof(line.c_str() + comma + 1);
+        }
+    }
+    file.close();
+    return true;
+}
+
+// Function to decide whether slot a should be marked before slot b
+bool exam_before(const ExamQueue* queue, int a, int b) {
+    const PendingExam& x = queue_exams(queue)[a];
+    const PendingExam& y = queue_exams(queue)[b];
+    
+    if (queue->policy == SCHEDULE_DEADLINE) {
+        // Exams without a deadline go after every exam that has one
+        bool x_due = x.deadline > 0;
+        bool y_due = y.deadline > 0;
+        if (x_due != y_due) {
+            return x_due;
+        }
+        if (x_due && x.deadline != y.deadline) {
+            return x.deadline < y.deadline;
+        }
+    }
+    if (queue->policy != SCHEDULE_FIFO && x.priority != y.priority) {
+        return x.priority > y.priority;
+    }
+    return x.exam_index < y.exam_index;
+}
+
+// Function to add a slot to the heap
+void queue_push(ExamQueue* queue, int slot) {
+    int i = queue->heap_size++;
+    queue_heap(queue)[i] = slot;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!exam_before(queue, queue_heap(queue)[i], queue_heap(queue)[parent])) {
+            break;
+        }
+        std::swap(queue_heap(queue)[i], queue_heap(queue)[parent]);
+        i = parent;
+    }
+}
+
+// Function to remove the next slot to mark (-1 if the queue is empty)
+int queue_pop(ExamQueue* queue) {
+    if (queue->heap_size == 0) {
+        return -1;
+    }
+    
+    int top = queue_heap(queue)[0];
+    queue_heap(queue)[0] = queue_heap(queue)[--queue->heap_size];
+    int i = 0;
+    while (true) {
+        int best = i;
+        int left = 2 * i + 1;
+        int right = 2 * i + 2;
+        if (left < queue->heap_size && exam_before(queue, queue_heap(queue)[left], queue_heap(queue)[best])) {
+            best = left;
+        }
+        if (right < queue->heap_size && exam_before(queue, queue_heap(queue)[right], queue_heap(queue)[best])) {
+            best = right;
+        }
+        if (best == i) {
+            break;
+        }
+        std::swap(queue_heap(queue)[i], queue_heap(queue)[best]);
+        i = best;
+    }
+    return top;
+}
+
+// Function to count exam files up to the first gap or the 9999 marker
+int count_exam_files() {
+    PendingExam pending;
+    int count = 0;
+    while (read_exam_file(count + 1, &pending) && pending.student_number != END_STUDENT) {
+        count++;
+    }
+    return count;
+}
+
+// Function to queue every exam file up to the first gap or the 9999 marker
+int load_exam_queue(ExamQueue* queue) {
+    queue->count = 0;
+    queue->heap_size = 0;
+    queue->current = -1;
+    queue->start_time = now_seconds();
+    queue->sem_ops = 0;
+    
+    for (int index = 1; queue->count < queue->capacity; index++) {
+        PendingExam* pending = &queue_exams(queue)[queue->count];
+        if (!read_exam_file(index, pending) || pending->student_number == END_STUDENT) {
+            break;
+        }
+        pending->queued_at = now_seconds();
+        pending->started_at = 0;
+        pending->finished_at = 0;
+        pending->skipped = false;
+        queue_push(queue, queue->count++);
+    }
+    return queue->count;
+}
+
+// Function to move the next scheduled exam into shared memory.
+// Exams whose file can no longer be read are skipped; loads the 9999 end
+// marker once the queue is empty.
+bool load_next_exam(CurrentExam* exam, ExamQueue* queue) {
+    while (true) {
+        int slot = queue_pop(queue);
+        queue->current = slot;
+        if (slot < 0) {
+            exam->student_number = END_STUDENT;
+            return false;
+        }
+        
+        PendingExam* pending = &queue_exams(queue)[slot];
+        if (load_exam(exam, pending->exam_index)) {
+            pending->started_at = now_seconds();
+            return true;
+        }
+        std::cerr << "Warning: Could not open exam " << pending->exam_index
+                  << " (student " << pending->student_number << "), skipping it" << std::endl;
+        pending->skipped = true;
+    }
+}
+
+// Function to print per-exam latency from queueing to fully marked
+void report_exam_latency(ExamQueue* queue) {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Student  Prio  Deadline    Wait(s)  Marking(s)  Latency(s)  Status" << std::endl;
+    
+    double total_latency = 0;
+    int finished = 0;
+    int missed = 0;
+    for (int i = 0; i < queue->count; i++) {
+        const PendingExam& e = queue_exams(queue)[i];
+        std::cout << std::setw(7) << e.student_number << "  "
+                  << std::setw(4) << e.priority << "  ";
+        if (e.deadline > 0) {
+            std::cout << std::setw(8) << e.deadline;
+        } else {
+            std::cout << std::setw(8) << "-";
+        }
+        
+        if (e.finished_at == 0) {
+            std::cout << "  " << std::setw(9) << "-" << "  " << std::setw(10) << "-"
+                      << "  " << std::setw(10) << "-" << "  "
+                      << (e.skipped ? "skipped (unreadable)" : "unfinished") << std::endl;
+            continue;
+        }
+        
+        double latency = e.finished_at - e.queued_at;
+        bool late = e.deadline > 0 && e.finished_at - queue->start_time > e.deadline;
+        std::cout << "  " << std::setw(9) << (e.started_at - e.queued_at)
+                  << "  " << std::setw(10) << (e.finished_at - e.started_at)
+                  << "  " << std::setw(10) << latency
+                  << "  " << (late ? "MISSED deadline" : "ok") << std::endl;
+        total_latency += latency;
+        finished++;
+        if (late) {
+            missed++;
+        }
+    }
+    
+    if (finished > 0) {
+        std::cout << "Mean latency: " << (total_latency / finished) << "s over " << finished
+                  << " exams, " << missed << " missed deadline(s)" << std::endl;
+        std::cout << "Semaphore operations: " << queue->sem_ops << " ("
+                  << (double)queue->sem_ops / finished << " per exam)" << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+
 // Function to check if all questions are marked
 bool all_questions_marked(CurrentExam* exam) {
     for (int i = 0; i < NUM_EXERCISES; i++) {
@@ -207,8 +505,8 @@ void rubric_write_unlock(int semid, int ta_id) {
 }
 
 // TA process function with semaphore synchronization
-void ta_process(int ta_id, Rubric* rubric, CurrentExam* exam, int semid) {
-    srand(time(NULL) + ta_id);
+void ta_process(int ta_id, Rubric* rubric, CurrentExam* exam, ExamQueue* queue, int semid) {
+    srand((base_seed < 0 ? time(NULL) : base_seed) + ta_id);
     
     std::cout << "[TA " << ta_id << "] ===== STARTED WORKING =====" << std::endl;
     
@@ -219,7 +517,7 @@ void ta_process(int ta_id, Rubric* rubric, CurrentExam* exam, int semid) {
         int current_student = exam->student_number;
         sem_signal(semid, SEM_EXAM_MUTEX);
         
-        if (current_student == 9999) {
+        if (current_student == END_STUDENT) {
             std::cout << "[TA " << ta_id << "] ===== FINISHED - reached student 9999 =====" << std::endl;
             break;
         }
@@ -308,6 +606,10 @@ void ta_process(int ta_id, Rubric* rubric, CurrentExam* exam, int semid) {
                 std::cout << "[TA " << ta_id << "] COMPLETED marking student " << student 
                           << ", question " << (q + 1) << std::endl;
                 
+                if (all_questions_marked(exam) && queue->current >= 0) {
+                    queue_exams(queue)[queue->current].finished_at = now_seconds();
+                }
+                
                 sem_signal(semid, SEM_EXAM_MUTEX);
                 break;
             }
@@ -333,17 +635,18 @@ void ta_process(int ta_id, Rubric* rubric, CurrentExam* exam, int semid) {
                 sem_wait(semid, SEM_EXAM_LOADING);  // Exclusive access for loading
                 std::cout << "[TA " << ta_id << "] ENTERED exam loading critical section" << std::endl;
                 
-                // Double-check after acquiring lock
+                // Double-check after acquiring lock (another TA may have
+                // loaded the next exam or the 9999 end marker meanwhile)
                 sem_wait(semid, SEM_EXAM_MUTEX);
-                if (all_questions_marked(exam)) {
+                if (all_questions_marked(exam) && exam->student_number != END_STUDENT) {
                     int old_student = exam->student_number;
-                    int next_exam_index = exam->exam_index + 1;
                     
-                    std::cout << "[TA " << ta_id << "] LOADING next exam (index " 
-                              << next_exam_index << ")..." << std::endl;
+                    std::cout << "[TA " << ta_id << "] LOADING next exam (" 
+                              << queue->heap_size << " pending)..." << std::endl;
                     
-                    if (!load_exam(exam, next_exam_index)) {
+                    if (!load_next_exam(exam, queue)) {
                         std::cout << "[TA " << ta_id << "] No more exams to load" << std::endl;
+                        exam->student_number = END_STUDENT;
                         sem_signal(semid, SEM_EXAM_MUTEX);
                         sem_signal(semid, SEM_EXAM_LOADING);
                         break;
@@ -359,15 +662,19 @@ void ta_process(int ta_id, Rubric* rubric, CurrentExam* exam, int semid) {
             } else {
                 sem_signal(semid, SEM_EXAM_MUTEX);
                 // Brief pause before trying again
-                usleep(100000);
+                usleep((int)(100000 * delay_scale));
             }
         }
     }
+    
+    __sync_fetch_and_add(&queue->sem_ops, sem_ops);
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <number_of_TAs>" << std::endl;
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <number_of_TAs>"
+                  << " [--placement=none|compact|scatter|node] [--delay-scale=X] [--seed=N]"
+                  << " [--schedule=fifo|priority|deadline]" << std::endl;
         return 1;
     }
     
@@ -377,11 +684,54 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    // Parse optional arguments
+    PlacementPolicy placement = PLACEMENT_NONE;
+    SchedulePolicy schedule = SCHEDULE_FIFO;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 12, "--placement=") == 0) {
+            if (!parse_placement(arg.substr(12), &placement)) {
+                std::cerr << "Error: Unknown placement policy '" << arg.substr(12) << "'" << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 7, "--seed=") == 0) {
+            base_seed = atol(arg.c_str() + 7);
+            if (base_seed < 0) {
+                std::cerr << "Error: Seed must not be negative" << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 14, "--delay-scale=") == 0) {
+            delay_scale = atof(arg.c_str() + 14);
+            if (delay_scale < 0) {
+                std::cerr << "Error: Delay scale must not be negative" << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 11, "--schedule=") == 0) {
+            if (!parse_schedule(arg.substr(11), &schedule)) {
+                std::cerr << "Error: Unknown schedule policy '" << arg.substr(11) << "'" << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "Error: Unknown option '" << arg << "'" << std::endl;
+            return 1;
+        }
+    }
+    if (placement != PLACEMENT_NONE && !placement_supported()) {
+        std::cerr << "Warning: --placement=" << placement_name(placement)
+                  << " is unsupported on this platform, using none" << std::endl;
+        placement = PLACEMENT_NONE;
+    }
+    
     std::cout << "========================================" << std::endl;
     std::cout << "Starting TA marking system with " << num_tas << " TAs" << std::endl;
     std::cout << "WITH SEMAPHORE SYNCHRONIZATION" << std::endl;
+    std::cout << "Placement policy: " << placement_name(placement) << std::endl;
+    std::cout << "Schedule policy: " << schedule_name(schedule) << std::endl;
     std::cout << "========================================" << std::endl;
     
+    CpuTopology topology = read_cpu_topology();
+    int shm_node = home_node(topology, placement, num_tas);
+    
     // Create shared memory for rubric
     int shm_rubric_id = shmget(IPC_PRIVATE, sizeof(Rubric), IPC_CREAT | 0666);
     if (shm_rubric_id < 0) {
@@ -394,6 +744,7 @@ int main(int argc, char* argv[]) {
         std::cerr << "Error: Failed to attach shared memory for rubric" << std::endl;
         return 1;
     }
+    bind_shared_segment(rubric, sizeof(Rubric), shm_node);
     
     // Create shared memory for current exam
     int shm_exam_id = shmget(IPC_PRIVATE, sizeof(CurrentExam), IPC_CREAT | 0666);
@@ -407,6 +758,27 @@ int main(int argc, char* argv[]) {
         std::cerr << "Error: Failed to attach shared memory for exam" << std::endl;
         return 1;
     }
+    bind_shared_segment(exam, sizeof(CurrentExam), shm_node);
+    
+    // Create shared memory for the exam queue, sized for every exam file
+    int queue_capacity = count_exam_files();
+    size_t queue_size = exam_queue_size(queue_capacity);
+    int shm_queue_id = shmget(IPC_PRIVATE, queue_size, IPC_CREAT | 0666);
+    if (shm_queue_id < 0) {
+        std::cerr << "Error: Failed to create shared memory for exam queue" << std::endl;
+        return 1;
+    }
+    
+    ExamQueue* queue = (ExamQueue*)shmat(shm_queue_id, NULL, 0);
+    if (queue == (void*)-1) {
+        std::cerr << "Error: Failed to attach shared memory for exam queue" << std::endl;
+        return 1;
+    }
+    bind_shared_segment(queue, queue_size, shm_node);
+    queue->capacity = queue_capacity;
+    if (shm_node >= 0) {
+        std::cout << "Shared memory placed on NUMA node " << shm_node << std::endl;
+    }
     
     // Create semaphore set
     int semid = semget(IPC_PRIVATE, NUM_SEMAPHORES, IPC_CREAT | 0666);
@@ -432,9 +804,16 @@ int main(int argc, char* argv[]) {
     load_rubric(rubric);
     std::cout << "Loaded rubric into shared memory" << std::endl;
     
-    // Load first exam
-    if (!load_exam(exam, 1)) {
-        std::cerr << "Error: Could not load first exam (exam_0001.txt)" << std::endl;
+    // Queue all exams and load the first one by schedule
+    queue->policy = schedule;
+    int num_exams = load_exam_queue(queue);
+    std::cout << "Queued " << num_exams << " exams" << std::endl;
+    if (num_exams == 0) {
+        std::cerr << "Error: No exams queued (exam_0001.txt missing?)" << std::endl;
+        return 1;
+    }
+    if (!load_next_exam(exam, queue)) {
+        std::cerr << "Error: Could not open any of the " << num_exams << " queued exams" << std::endl;
         return 1;
     }
     std::cout << "Loaded first exam (student " << exam->student_number << ")" << std::endl;
@@ -450,7 +829,12 @@ int main(int argc, char* argv[]) {
             return 1;
         } else if (pid == 0) {
             // Child process (TA)
-            ta_process(i + 1, rubric, exam, semid);
+            TaPlacement ta_cpus = place_ta(topology, placement, i, num_tas);
+            if (!ta_cpus.cpus.empty() && apply_ta_placement(ta_cpus)) {
+                std::cout << "[TA " << (i + 1) << "] PINNED to CPUs " << cpu_list_string(ta_cpus.cpus)
+                          << " (node " << ta_cpus.node << ")" << std::endl;
+            }
+            ta_process(i + 1, rubric, exam, queue, semid);
             exit(0);
         } else {
             // Parent process
@@ -466,12 +850,16 @@ int main(int argc, char* argv[]) {
     std::cout << std::endl << "========================================" << std::endl;
     std::cout << "All TAs have finished marking" << std::endl;
     std::cout << "========================================" << std::endl;
+    report_exam_latency(queue);
+    std::cout << "========================================" << std::endl;
     
     // Cleanup
     shmdt(rubric);
     shmdt(exam);
+    shmdt(queue);
     shmctl(shm_rubric_id, IPC_RMID, NULL);
     shmctl(shm_exam_id, IPC_RMID, NULL);
+    shmctl(shm_queue_id, IPC_RMID, NULL);
     semctl(semid, 0, IPC_RMID);
     
     std::cout << "Cleaned up shared memory and semaphores" << std::endl;
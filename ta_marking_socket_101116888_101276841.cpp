@@ -0,0 +1,777 @@
+/**
+ * @file ta_marking_socket.cpp
+ * @brief Assignment 3 Part 2b variant - Coordinator/worker TA marking over sockets
+ * @author Student Implementation
+ *
+ * Parts 2a and 2b share the rubric and exam through System V shared memory,
+ * which ties every TA to one machine. Here a single coordinator process owns
+ * the rubric and the exam queue, and TA worker processes talk to it over a
+ * stream socket (a Unix domain socket for local testing).
+ *
+ * Because the coordinator handles one request at a time, it needs no
+ * semaphores: each request is its own critical section. To keep round-trips
+ * down, a worker claims up to --batch questions per request, reports the
+ * previous batch as completed in the same request, and every reply carries
+ * the current rubric so the next review needs no extra request.
+ *
+ * Compile: g++ -o ta_marking_socket ta_marking_socket.cpp
+ * Run: ./ta_marking_socket <number_of_TAs> [--batch=K] [--socket=PATH]
+ *                          [--role=all|coordinator|worker] [--delay-scale=X]
+ *
+ *   --role=all          coordinator plus <number_of_TAs> forked workers (default)
+ *   --role=coordinator  serve until <number_of_TAs> workers have connected and left,
+ *                       or until the exams run out and no worker is connected
+ *   --role=worker       fork <number_of_TAs> workers against a running coordinator
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <cstdlib>
+#include <ctime>
+#include <chrono>
+#include <iomanip>
+
+// Constants
+#define NUM_EXERCISES 5
+#define END_STUDENT 9999
+#define RUBRIC_FILE "rubric.txt"
+#define EXAM_PREFIX "exam_"
+#define EXAM_SUFFIX ".txt"
+#define DEFAULT_SOCKET "ta_marking.sock"
+#define MAX_BATCH NUM_EXERCISES
+#define CONNECT_RETRIES 50
+#define REAP_INTERVAL_MS 100
+
+// Request types sent by workers
+#define MSG_GET_RUBRIC 0     // Fetch the rubric (first request only)
+#define MSG_RUBRIC_UPDATE 1  // Correct one rubric exercise
+#define MSG_CLAIM 2          // Report completed questions and claim more
+
+// Reply types sent by the coordinator
+#define REPLY_OK 0           // questions[] holds the claimed questions (may be empty)
+#define REPLY_DONE 1         // Reached student 9999 / no more exams
+
+// Rubric owned by the coordinator
+struct Rubric {
+    char exercises[NUM_EXERCISES][100];
+};
+
+// Exam currently being marked, owned by the coordinator
+struct CurrentExam {
+    int student_number;
+    bool questions_marked[NUM_EXERCISES];
+    int exam_index;
+    bool being_marked[NUM_EXERCISES];
+};
+
+// Worker -> coordinator message (fixed size)
+struct Request {
+    int type;
+    int ta_id;
+    int exercise;           // MSG_RUBRIC_UPDATE
+    int claim_count;        // MSG_CLAIM: questions wanted
+    int student;            // MSG_CLAIM: student of the completed questions
+    int completed_count;    // MSG_CLAIM: questions finished since last claim
+    int completed[MAX_BATCH];
+};
+
+// Coordinator -> worker message (fixed size); always carries the rubric
+struct Response {
+    int type;
+    int student;
+    int count;
+    int questions[MAX_BATCH];
+    Rubric rubric;
+};
+
+// Round-trip counters kept by the coordinator
+struct CoordinatorStats {
+    long rubric_requests;
+    long update_requests;
+    long claim_requests;
+    long empty_claims;       // Claims that returned no question
+    long filled_claims;      // Claims that returned at least one question
+    long questions_claimed;
+    int exams_completed;
+};
+
+// Coordinator's view of one connection. A connection only counts towards
+// <number_of_TAs> once it sends a request, so a bare connect (such as another
+// coordinator checking for a stale socket) cannot take a worker's place.
+struct WorkerConnection {
+    bool registered;
+    int student;                    // Student the claimed questions belong to
+    bool claimed[NUM_EXERCISES];    // Claimed but not yet reported completed
+};
+
+// Multiplier applied to every simulated delay (set with --delay-scale)
+double delay_scale = 1.0;
+
+// Function to generate random delay between min and max seconds
+void random_delay(double min_sec, double max_sec) {
+    double random_time = min_sec + (max_sec - min_sec) * ((double)rand() / RAND_MAX);
+    random_time *= delay_scale;
+    int microseconds = (int)(random_time * 1000000);
+    usleep(microseconds);
+}
+
+// Function to load rubric from file
+void load_rubric(Rubric* rubric) {
+    std::ifstream file(RUBRIC_FILE);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open rubric file" << std::endl;
+        return;
+    }
+
+    std::string line;
+    int index = 0;
+    while (std::getline(file, line) && index < NUM_EXERCISES) {
+        strncpy(rubric->exercises[index], line.c_str(), 99);
+        rubric->exercises[index][99] = '\0';
+        index++;
+    }
+    file.close();
+}
+
+// Function to save rubric to file
+void save_rubric(Rubric* rubric) {
+    std::ofstream file(RUBRIC_FILE);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not save rubric file" << std::endl;
+        return;
+    }
+
+    for (int i = 0; i < NUM_EXERCISES; i++) {
+        file << rubric->exercises[i] << std::endl;
+    }
+    file.close();
+}
+
+// Function to load exam from file
+bool load_exam(CurrentExam* exam, int exam_index) {
+    std::stringstream ss;
+    ss << EXAM_PREFIX << std::setfill('0') << std::setw(4) << exam_index << EXAM_SUFFIX;
+    std::string filename = ss.str();
+
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    if (std::getline(file, line)) {
+        exam->student_number = std::stoi(line);
+        exam->exam_index = exam_index;
+        // Reset all questions to unmarked
+        for (int i = 0; i < NUM_EXERCISES; i++) {
+            exam->questions_marked[i] = false;
+            exam->being_marked[i] = false;
+        }
+    }
+    file.close();
+    return true;
+}
+
+// Function to check if all questions are marked
+bool all_questions_marked(CurrentExam* exam) {
+    for (int i = 0; i < NUM_EXERCISES; i++) {
+        if (!exam->questions_marked[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Function to read exactly size bytes; returns false on EOF or error
+bool read_full(int fd, void* buffer, size_t size) {
+    char* p = (char*)buffer;
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+// Function to write exactly size bytes; MSG_NOSIGNAL turns a departed peer
+// into an EPIPE error instead of a SIGPIPE that would kill the process
+bool write_full(int fd, const void* buffer, size_t size) {
+    const char* p = (const char*)buffer;
+    while (size > 0) {
+        ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+// Function to fill in a socket address for path
+bool make_address(const std::string& path, struct sockaddr_un* addr) {
+    if (path.size() >= sizeof(addr->sun_path)) {
+        std::cerr << "Error: Socket path too long" << std::endl;
+        return false;
+    }
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    strncpy(addr->sun_path, path.c_str(), sizeof(addr->sun_path) - 1);
+    return true;
+}
+
+// Function to remove a socket file left behind by a coordinator that died.
+// Anything that is not a socket, or a socket something still listens on, is
+// left alone.
+bool remove_stale_socket(const std::string& path, const struct sockaddr_un& addr) {
+    struct stat st;
+    if (lstat(path.c_str(), &st) < 0) {
+        if (errno == ENOENT) {
+            return true;
+        }
+        perror("lstat failed");
+        return false;
+    }
+    if (!S_ISSOCK(st.st_mode)) {
+        std::cerr << "Error: " << path << " exists and is not a socket" << std::endl;
+        return false;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket failed");
+        return false;
+    }
+    int result = connect(fd, (const struct sockaddr*)&addr, sizeof(addr));
+    int error = errno;
+    close(fd);
+    if (result == 0) {
+        std::cerr << "Error: A coordinator is already listening on " << path << std::endl;
+        return false;
+    }
+    if (error != ECONNREFUSED) {
+        std::cerr << "Error: Could not check socket " << path << ": " << strerror(error) << std::endl;
+        return false;
+    }
+    if (unlink(path.c_str()) < 0) {
+        perror("unlink failed");
+        return false;
+    }
+    return true;
+}
+
+// Function to create the coordinator's listening socket
+int listen_socket(const std::string& path) {
+    struct sockaddr_un addr;
+    if (!make_address(path, &addr)) {
+        return -1;
+    }
+    if (!remove_stale_socket(path, addr)) {
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket failed");
+        return -1;
+    }
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("bind failed");
+        close(fd);
+        return -1;
+    }
+    if (listen(fd, SOMAXCONN) < 0) {
+        perror("listen failed");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Function to connect a worker, retrying while the coordinator starts up
+int connect_socket(const std::string& path) {
+    struct sockaddr_un addr;
+    if (!make_address(path, &addr)) {
+        return -1;
+    }
+
+    for (int attempt = 0; attempt < CONNECT_RETRIES; attempt++) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            perror("socket failed");
+            return -1;
+        }
+        if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0) {
+            return fd;
+        }
+        close(fd);
+        usleep(100000);
+    }
+    std::cerr << "Error: Could not connect to coordinator at " << path << std::endl;
+    return -1;
+}
+
+// Function to handle one worker request; the coordinator is single threaded,
+// so every request runs as its own critical section
+void handle_request(const Request& request, Response* response, Rubric* rubric,
+                    CurrentExam* exam, bool* finished, CoordinatorStats* stats,
+                    WorkerConnection* worker) {
+    memset(response, 0, sizeof(*response));
+    response->type = REPLY_OK;
+
+    if (request.type == MSG_GET_RUBRIC) {
+        stats->rubric_requests++;
+    } else if (request.type == MSG_RUBRIC_UPDATE) {
+        stats->update_requests++;
+        int i = request.exercise;
+        if (i >= 0 && i < NUM_EXERCISES) {
+            char* comma = strchr(rubric->exercises[i], ',');
+            if (comma != NULL && *(comma + 1) == ' ') {
+                char& rubric_char = *(comma + 2);
+                std::cout << "[Coordinator] TA " << request.ta_id << " changed exercise " << (i + 1)
+                          << " rubric from '" << rubric_char << "' to '" << (char)(rubric_char + 1)
+                          << "'" << std::endl;
+                rubric_char++;
+                save_rubric(rubric);
+            }
+        }
+    } else if (request.type == MSG_CLAIM) {
+        stats->claim_requests++;
+
+        // Record questions finished since the worker's last claim
+        if (request.student == exam->student_number) {
+            for (int c = 0; c < request.completed_count && c < MAX_BATCH; c++) {
+                int q = request.completed[c];
+                if (q >= 0 && q < NUM_EXERCISES) {
+                    exam->questions_marked[q] = true;
+                    exam->being_marked[q] = false;
+                    worker->claimed[q] = false;
+                }
+            }
+        }
+
+        // Load the next exam as soon as the current one is fully marked
+        if (!*finished && all_questions_marked(exam)) {
+            stats->exams_completed++;
+            int old_student = exam->student_number;
+            if (!load_exam(exam, exam->exam_index + 1) || exam->student_number == END_STUDENT) {
+                std::cout << "[Coordinator] No more exams to load after student " << old_student << std::endl;
+                *finished = true;
+            } else {
+                std::cout << "[Coordinator] LOADED exam for student " << exam->student_number
+                          << " (was " << old_student << ")" << std::endl;
+            }
+        }
+
+        if (*finished) {
+            response->type = REPLY_DONE;
+        } else {
+            response->student = exam->student_number;
+            if (worker->student != exam->student_number) {
+                worker->student = exam->student_number;
+                memset(worker->claimed, 0, sizeof(worker->claimed));
+            }
+            int wanted = request.claim_count < MAX_BATCH ? request.claim_count : MAX_BATCH;
+            for (int q = 0; q < NUM_EXERCISES && response->count < wanted; q++) {
+                if (!exam->questions_marked[q] && !exam->being_marked[q]) {
+                    exam->being_marked[q] = true;
+                    worker->claimed[q] = true;
+                    response->questions[response->count++] = q;
+                }
+            }
+            stats->questions_claimed += response->count;
+            if (response->count == 0) {
+                stats->empty_claims++;
+            } else {
+                stats->filled_claims++;
+            }
+        }
+    }
+
+    response->rubric = *rubric;
+}
+
+// Function to hand a departed worker's unfinished questions back to the pool
+void release_claims(const WorkerConnection& worker, CurrentExam* exam) {
+    if (worker.student != exam->student_number) {
+        return;
+    }
+    int released = 0;
+    for (int q = 0; q < NUM_EXERCISES; q++) {
+        if (worker.claimed[q] && !exam->questions_marked[q]) {
+            exam->being_marked[q] = false;
+            released++;
+        }
+    }
+    if (released > 0) {
+        std::cout << "[Coordinator] Worker disconnected, released " << released
+                  << " claimed question(s) of student " << exam->student_number << std::endl;
+    }
+}
+
+// Function to collect exited worker processes, removing them from pids.
+// Returns how many of them failed.
+int reap_workers(std::vector<pid_t>* pids, bool block) {
+    int failed = 0;
+    for (size_t i = 0; i < pids->size(); ) {
+        int ta_status = 0;
+        pid_t done = waitpid((*pids)[i], &ta_status, block ? 0 : WNOHANG);
+        if (done == 0) {
+            i++;
+            continue;
+        }
+        if (done < 0 || !WIFEXITED(ta_status) || WEXITSTATUS(ta_status) != 0) {
+            failed++;
+        }
+        pids->erase(pids->begin() + i);
+    }
+    return failed;
+}
+
+// Coordinator: serve requests until every worker that is coming has left.
+// That is num_tas workers, or fewer once the exams run out (ta_pids NULL,
+// role coordinator) or once every forked worker in ta_pids has exited (role
+// all). Forked workers that exit while serving are reaped here and any that
+// failed are added to *failed_workers.
+int run_coordinator(int listen_fd, int num_tas, Rubric* rubric, CurrentExam* exam,
+                    std::vector<pid_t>* ta_pids, int* failed_workers) {
+    CoordinatorStats stats;
+    memset(&stats, 0, sizeof(stats));
+    bool finished = false;
+    int connected = 0;  // Workers that have sent a request
+    int active = 0;     // Of those, workers still connected
+
+    std::vector<struct pollfd> fds;
+    struct pollfd listener;
+    listener.fd = listen_fd;
+    listener.events = POLLIN;
+    fds.push_back(listener);
+    std::vector<WorkerConnection> workers(1);  // workers[i] belongs to fds[i]
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    while (true) {
+        if (ta_pids != NULL) {
+            *failed_workers += reap_workers(ta_pids, false);
+        }
+        // A late worker would only be told REPLY_DONE, so stop waiting for it
+        bool more_coming = ta_pids != NULL ? !ta_pids->empty() : !finished;
+        if (active == 0 && (connected == num_tas || !more_coming)) {
+            break;
+        }
+
+        // Wake up periodically to notice workers that died before connecting
+        int timeout = (ta_pids != NULL && !ta_pids->empty()) ? REAP_INTERVAL_MS : -1;
+        if (poll(&fds[0], fds.size(), timeout) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("poll failed");
+            return 1;
+        }
+
+        // Serve existing workers first, dropping any that disconnected
+        for (size_t i = 1; i < fds.size(); ) {
+            if (fds[i].revents == 0) {
+                i++;
+                continue;
+            }
+            Request request;
+            Response response;
+            bool ok = read_full(fds[i].fd, &request, sizeof(request));
+            if (ok && !workers[i].registered) {
+                workers[i].registered = true;
+                connected++;
+                active++;
+                std::cout << "[Coordinator] Worker connected (" << connected << "/" << num_tas << ")" << std::endl;
+                if (connected == num_tas) {
+                    // Accept no more workers
+                    fds[0].events = 0;
+                }
+            }
+            if (ok) {
+                handle_request(request, &response, rubric, exam, &finished, &stats, &workers[i]);
+                ok = write_full(fds[i].fd, &response, sizeof(response));
+            }
+            if (!ok) {
+                if (workers[i].registered) {
+                    release_claims(workers[i], exam);
+                    active--;
+                }
+                close(fds[i].fd);
+                fds.erase(fds.begin() + i);
+                workers.erase(workers.begin() + i);
+                continue;
+            }
+            i++;
+        }
+
+        if (connected < num_tas && (fds[0].revents & POLLIN)) {
+            int client = accept(listen_fd, NULL, NULL);
+            if (client >= 0) {
+                struct pollfd worker;
+                worker.fd = client;
+                worker.events = POLLIN;
+                fds.push_back(worker);
+                WorkerConnection connection;
+                memset(&connection, 0, sizeof(connection));
+                connection.student = -1;
+                workers.push_back(connection);
+            }
+        }
+    }
+
+    // Close connections that never sent a request
+    for (size_t i = 1; i < fds.size(); i++) {
+        close(fds[i].fd);
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long round_trips = stats.rubric_requests + stats.update_requests + stats.claim_requests;
+    int exams = stats.exams_completed > 0 ? stats.exams_completed : 1;
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Coordinator statistics" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Exams completed:        " << stats.exams_completed << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Elapsed time:           " << elapsed << "s" << std::endl;
+    std::cout << "Round trips:            " << round_trips << std::endl;
+    std::cout << "  rubric fetches:       " << stats.rubric_requests << std::endl;
+    std::cout << "  rubric updates:       " << stats.update_requests << std::endl;
+    std::cout << "  claims:               " << stats.claim_requests
+              << " (" << stats.empty_claims << " empty)" << std::endl;
+    std::cout << "Round trips per exam:   " << (double)round_trips / exams << std::endl;
+    std::cout << "Questions per claim:    "
+              << (stats.filled_claims > 0 ? (double)stats.questions_claimed / stats.filled_claims : 0.0)
+              << std::endl;
+    return 0;
+}
+
+// Function to send one request and wait for the reply
+bool round_trip(int fd, const Request& request, Response* response) {
+    return write_full(fd, &request, sizeof(request)) && read_full(fd, response, sizeof(*response));
+}
+
+// Worker: same review/mark cycle as a Part 2b TA, driven by requests.
+// Returns false if the worker could not finish talking to the coordinator.
+bool worker_process(int ta_id, const std::string& socket_path, int batch) {
+    srand(time(NULL) + ta_id);
+
+    int fd = connect_socket(socket_path);
+    if (fd < 0) {
+        return false;
+    }
+
+    std::cout << "[TA " << ta_id << "] ===== STARTED WORKING =====" << std::endl;
+
+    Request request;
+    Response response;
+    memset(&request, 0, sizeof(request));
+    request.ta_id = ta_id;
+    request.type = MSG_GET_RUBRIC;
+    if (!round_trip(fd, request, &response)) {
+        std::cerr << "Error: Lost connection to coordinator" << std::endl;
+        close(fd);
+        return false;
+    }
+
+    int student = -1;
+    while (true) {
+        // Review the rubric snapshot from the last reply
+        for (int i = 0; i < NUM_EXERCISES; i++) {
+            random_delay(0.5, 1.0);
+
+            if ((rand() % 100) < 30) {
+                std::cout << "[TA " << ta_id << "] REQUESTING correction of rubric exercise "
+                          << (i + 1) << std::endl;
+                request.type = MSG_RUBRIC_UPDATE;
+                request.exercise = i;
+                if (!round_trip(fd, request, &response)) {
+                    std::cerr << "Error: Lost connection to coordinator" << std::endl;
+                    close(fd);
+                    return false;
+                }
+            }
+        }
+
+        // Report the finished batch and claim the next one
+        request.type = MSG_CLAIM;
+        request.claim_count = batch;
+        request.student = student;
+        if (!round_trip(fd, request, &response)) {
+            std::cerr << "Error: Lost connection to coordinator" << std::endl;
+            close(fd);
+            return false;
+        }
+        request.completed_count = 0;
+
+        if (response.type == REPLY_DONE) {
+            std::cout << "[TA " << ta_id << "] ===== FINISHED - reached student 9999 =====" << std::endl;
+            break;
+        }
+
+        if (response.count == 0) {
+            // Brief pause before trying again
+            usleep((int)(100000 * delay_scale));
+            continue;
+        }
+
+        student = response.student;
+        for (int c = 0; c < response.count; c++) {
+            int q = response.questions[c];
+            std::cout << "[TA " << ta_id << "] MARKING student " << student
+                      << ", question " << (q + 1) << std::endl;
+            random_delay(1.0, 2.0);
+            request.completed[request.completed_count++] = q;
+        }
+    }
+
+    close(fd);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <number_of_TAs> [--batch=K] [--socket=PATH]"
+                  << " [--role=all|coordinator|worker] [--delay-scale=X]" << std::endl;
+        return 1;
+    }
+
+    int num_tas = atoi(argv[1]);
+    if (num_tas < 1) {
+        std::cerr << "Error: Number of TAs must be at least 1" << std::endl;
+        return 1;
+    }
+
+    // Parse optional arguments
+    int batch = 1;
+    std::string socket_path = DEFAULT_SOCKET;
+    std::string role = "all";
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 8, "--batch=") == 0) {
+            batch = atoi(arg.c_str() + 8);
+            if (batch < 1 || batch > MAX_BATCH) {
+                std::cerr << "Error: Batch size must be between 1 and " << MAX_BATCH << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 9, "--socket=") == 0) {
+            socket_path = arg.substr(9);
+        } else if (arg.compare(0, 7, "--role=") == 0) {
+            role = arg.substr(7);
+            if (role != "all" && role != "coordinator" && role != "worker") {
+                std::cerr << "Error: Unknown role '" << role << "'" << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 14, "--delay-scale=") == 0) {
+            delay_scale = atof(arg.c_str() + 14);
+            if (delay_scale < 0) {
+                std::cerr << "Error: Delay scale must not be negative" << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "Error: Unknown option '" << arg << "'" << std::endl;
+            return 1;
+        }
+    }
+    if (role == "all" && num_tas < 2) {
+        std::cerr << "Error: Number of TAs must be at least 2" << std::endl;
+        return 1;
+    }
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "Starting TA marking system with " << num_tas << " TAs" << std::endl;
+    std::cout << "COORDINATOR/WORKER over " << socket_path << " (role " << role
+              << ", batch " << batch << ")" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    int listen_fd = -1;
+    Rubric rubric;
+    CurrentExam exam;
+    if (role != "worker") {
+        memset(&rubric, 0, sizeof(rubric));
+        load_rubric(&rubric);
+        std::cout << "Loaded rubric" << std::endl;
+
+        if (!load_exam(&exam, 1)) {
+            std::cerr << "Error: Could not load first exam (exam_0001.txt)" << std::endl;
+            return 1;
+        }
+        std::cout << "Loaded first exam (student " << exam.student_number << ")" << std::endl;
+
+        // Listen before forking so workers never race the coordinator
+        listen_fd = listen_socket(socket_path);
+        if (listen_fd < 0) {
+            return 1;
+        }
+    }
+    std::cout << "========================================" << std::endl << std::endl;
+
+    // Create worker processes
+    std::vector<pid_t> ta_pids;
+    if (role != "coordinator") {
+        for (int i = 0; i < num_tas; i++) {
+            pid_t pid = fork();
+
+            if (pid < 0) {
+                std::cerr << "Error: Failed to fork TA process " << i << std::endl;
+                return 1;
+            } else if (pid == 0) {
+                // Child process (TA worker)
+                if (listen_fd >= 0) {
+                    close(listen_fd);
+                }
+                exit(worker_process(i + 1, socket_path, batch) ? 0 : 1);
+            } else {
+                // Parent process
+                ta_pids.push_back(pid);
+            }
+        }
+    }
+
+    int status = 0;
+    int failed = 0;
+    size_t num_workers = ta_pids.size();
+    if (role != "worker") {
+        status = run_coordinator(listen_fd, num_tas, &rubric, &exam,
+                                 role == "all" ? &ta_pids : NULL, &failed);
+        close(listen_fd);
+        unlink(socket_path.c_str());
+    }
+
+    // Wait for all TA processes to finish
+    failed += reap_workers(&ta_pids, true);
+
+    std::cout << "========================================" << std::endl;
+    if (failed > 0) {
+        std::cout << failed << " of " << num_workers << " TAs did not finish marking" << std::endl;
+        status = 1;
+    } else {
+        std::cout << "All TAs have finished marking" << std::endl;
+    }
+    std::cout << "========================================" << std::endl;
+
+    return status;
+}